@@ -0,0 +1,409 @@
+/*
+* @file BiasedFileLock.hpp
+* @brief Biased ("sticky") file locking - the kernel lock outlives the lock context
+* @author Kagan Can Sit
+*
+* For lock files that are almost always used by the same process, releasing a biased lock only changes in-process
+* state while the kernel lock (fcntl / LockFileEx) stays held. Re-acquiring it in that process is then purely
+* in-memory - no open(), fcntl() or close() per acquisition.
+*
+* Other processes revoke the bias through the waiter signal of FileLockWaiters.hpp: every blocking or timed
+* acquisition of the library (plain or biased) that has to wait raises it. The owner checks for it every
+* revocation delay and then truly releases at its next release point, or at once if the lock is idle.
+*
+* The in-process state of a path lives until the process exits; no scope object has to keep it alive. The kernel
+* lock is held from the first acquisition until another process waits for it, and is then taken again by the
+* next acquisition in this process. A child created by fork() ignores the states it inherited and starts its own.
+*
+* @warning Contenders that do not use this library (or only try_lock) do not raise the waiter signal and wait
+* until the owner process exits or the bias is revoked by someone else.
+* @warning Never mix plain and biased locking of one path in the same process - this includes the contexts passed
+* to FileLockCondition and the locks taken by LeaderElection. Closing a plain context drops the process's fcntl lock while the biased state
+* still believes it holds it - the plain factory methods therefore refuse paths that have been used in biased mode.
+* @warning Use the same path spelling for a file throughout the process; the in-process state is keyed by it.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#include "FileLockStrategy.hpp"
+#include "FileLockWaiters.hpp"
+
+namespace file_lock {
+	namespace detail {
+		/**
+		 * @brief Process-wide state of one biased lock file
+		 *
+		 * Created on the first biased use of a path and kept until the process exits, so a lock context costs no
+		 * more than a registry lookup. Owns the platform strategy that holds the kernel lock. While the kernel lock
+		 * is held, a revoker thread probes the waiter signal and gives the lock away once another process waits.
+		 *
+		 * States are never destroyed. No teardown can race with a new acquisition of the same path, and a child
+		 * created by fork() abandons the states it inherited instead of closing their descriptors - which would
+		 * drop the child's own fcntl() locks on the file.
+		 */
+		class BiasedLockState final {
+		public:
+			using Deadline = std::optional<std::chrono::steady_clock::time_point>;
+
+			// Upper bound for how long an idle biased lock is kept while another process is waiting
+			static constexpr std::chrono::milliseconds RevocationDelay{ 10 };
+
+			BiasedLockState(const std::filesystem::path& file_path, std::unique_ptr<IFileLockStrategy> kernelLock) noexcept
+				: m_kernelLock(std::move(kernelLock)), m_waiters(file_path, true), m_forkGeneration(s_forkGeneration.load(std::memory_order_relaxed)) {
+			}
+
+			/**
+			 * @brief Returns the state of a lock file, creating it on first use
+			 * @param file_path Path to the lock file
+			 * @param createKernelLock Creates the platform strategy if the path has no state yet
+			 * @return State (valid until the process exits), or nullptr if no platform strategy is available
+			 */
+			[[nodiscard]] static BiasedLockState* Get(const std::filesystem::path& file_path,
+				const std::function<std::unique_ptr<IFileLockStrategy>()>& createKernelLock) noexcept {
+				auto& registry = GetRegistry();
+				std::lock_guard guard(registry.mutex);
+				AbandonInheritedStates(registry);
+
+				// Keyed by spelling, not by canonical path - resolving it would cost a syscall on every acquisition
+				auto entry = registry.states.find(file_path);
+				if (entry != registry.states.end()) {
+					return entry->second;
+				}
+
+				auto kernelLock = createKernelLock();
+				if (!kernelLock) {
+					return nullptr;
+				}
+				auto* state = new BiasedLockState(file_path, std::move(kernelLock));
+				registry.states.emplace(file_path, state);
+				return state;
+			}
+
+			/**
+			 * @brief Returns whether this process has used the path in biased mode
+			 * @param file_path Path to the lock file
+			 * @note Stays true until the process exits, even while the kernel lock is given away
+			 */
+			[[nodiscard]] static bool IsActive(const std::filesystem::path& file_path) noexcept {
+				auto& registry = GetRegistry();
+				std::lock_guard guard(registry.mutex);
+				AbandonInheritedStates(registry);
+				return registry.states.contains(file_path);
+			}
+
+			/**
+			 * @brief Acquires the lock for one more in-process holder
+			 *
+			 * The kernel wait happens outside the state mutex. Other threads of this process meanwhile wait for
+			 * its outcome (or fail immediately if nonBlocking) instead of queueing on the mutex.
+			 *
+			 * @param acquireKernelLock Acquisition used when the kernel lock is not held by this process
+			 * @param nonBlocking Fail instead of waiting while another thread acquires the kernel lock
+			 * @param deadline Latest time to wait for another thread's acquisition, std::nullopt for no limit
+			 * @param stopToken Token that cancels waiting for another thread's acquisition
+			 * @return LockStatus::Acquired if the lock is held, otherwise the reason it is not
+			 */
+			[[nodiscard]] LockStatus Acquire(const std::function<LockStatus(IFileLockStrategy&)>& acquireKernelLock, bool nonBlocking, Deadline deadline, const std::stop_token& stopToken) noexcept {
+				if (IsInherited()) {
+					return LockStatus::Failed;
+				}
+
+				std::unique_lock guard(m_mutex);
+				const auto isReady = [this] { return m_kernelHeld || !m_acquiring; };
+				if (!isReady()) {
+					if (nonBlocking) {
+						return LockStatus::Failed;
+					}
+
+					const bool ready = deadline ? m_stateChanged.wait_until(guard, stopToken, *deadline, isReady) : m_stateChanged.wait(guard, stopToken, isReady);
+					if (!ready) {
+						return stopToken.stop_requested() ? LockStatus::Cancelled : LockStatus::TimedOut;
+					}
+				}
+
+				if (!m_kernelHeld) {
+					m_acquiring = true;
+					guard.unlock();
+
+					// The platform strategy raises the waiter signal itself if it has to wait
+					const LockStatus status = acquireKernelLock(*m_kernelLock);
+
+					guard.lock();
+					m_acquiring = false;
+					m_kernelHeld = status == LockStatus::Acquired;
+					m_stateChanged.notify_all(); // Queued threads - rare, not per acquisition
+
+					if (!m_kernelHeld) {
+						return status;
+					}
+					StartRevoker();
+				}
+
+				++m_holders;
+				return LockStatus::Acquired;
+			}
+
+			/**
+			 * @brief Releases one in-process holder - the kernel lock is only dropped if another process waits
+			 */
+			void Release() noexcept {
+				if (IsInherited()) {
+					return; // Never touch the parent's kernel lock, mutex or revoker from a fork()ed child
+				}
+
+				std::lock_guard guard(m_mutex);
+				if (m_holders > 0 && --m_holders == 0 && m_revokeRequested) {
+					ReleaseKernelLock();
+				}
+			}
+
+			// Disable copy and move operations
+			BiasedLockState(const BiasedLockState&) = delete;
+			BiasedLockState& operator=(const BiasedLockState&) = delete;
+			BiasedLockState(BiasedLockState&&) = delete;
+			BiasedLockState& operator=(BiasedLockState&&) = delete;
+
+		private:
+			struct PathHash {
+				[[nodiscard]] std::size_t operator()(const std::filesystem::path& file_path) const noexcept {
+					return std::filesystem::hash_value(file_path);
+				}
+			};
+
+			struct Registry {
+				std::mutex mutex{};
+				std::uint32_t forkGeneration{ 0 }; // Generation the states below belong to
+				std::unordered_map<std::filesystem::path, BiasedLockState*, PathHash> states{}; // Never deleted
+			};
+
+			/**
+			 * @brief Returns the registry of all states of this process
+			 *
+			 * Intentionally leaked: a revoker thread may still use its state while static objects are destroyed at
+			 * exit. The fork() handlers keep the registry mutex consistent in the child and advance the generation.
+			 */
+			[[nodiscard]] static Registry& GetRegistry() noexcept {
+				static Registry* registry = [] {
+#if defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+					pthread_atfork(
+						[] { GetRegistry().mutex.lock(); },
+						[] { GetRegistry().mutex.unlock(); },
+						[] {
+							s_forkGeneration.fetch_add(1, std::memory_order_relaxed);
+							GetRegistry().mutex.unlock();
+						});
+#endif
+					return new Registry{};
+				}();
+				return *registry;
+			}
+
+			/**
+			 * @brief Forgets the states inherited from the parent process, without destroying them
+			 * @note Requires the registry mutex
+			 */
+			static void AbandonInheritedStates(Registry& registry) noexcept {
+				const auto forkGeneration = s_forkGeneration.load(std::memory_order_relaxed);
+				if (registry.forkGeneration != forkGeneration) {
+					registry.states.clear(); // Pointers only - the states and their descriptors are leaked on purpose
+					registry.forkGeneration = forkGeneration;
+				}
+			}
+
+			/**
+			 * @brief Returns whether the state was created by the parent of this (fork()ed) process
+			 * @note A relaxed atomic load - unlike getpid(), not a system call on every acquisition
+			 */
+			[[nodiscard]] bool IsInherited() const noexcept {
+				return m_forkGeneration != s_forkGeneration.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * @brief Starts the revoker thread for a freshly acquired kernel lock unless it is still running
+			 * @note Requires m_mutex
+			 */
+			void StartRevoker() noexcept {
+				if (m_revokerRunning) {
+					return;
+				}
+
+				try {
+					// Detached - the state is never destroyed, and the thread ends with the kernel lock
+					std::thread([this] { RevokeLoop(); }).detach();
+					m_revokerRunning = true;
+				}
+				catch (...) {
+					m_revokeRequested = true; // Nobody could give an idle lock away - do not keep it
+				}
+			}
+
+			void ReleaseKernelLock() noexcept {
+				m_kernelLock->unlock();
+				m_kernelHeld = false;
+				m_revokeRequested = false;
+				m_stateChanged.notify_all(); // Lets the revoker end
+			}
+
+			/**
+			 * @brief Probes the waiter signal every RevocationDelay while the kernel lock is held, then ends
+			 *
+			 * An idle lock is released at once; otherwise the last holder releases it (m_revokeRequested). The probe
+			 * is a system call, so it runs outside m_mutex and only here - never on the acquisition path.
+			 */
+			void RevokeLoop() noexcept {
+				std::unique_lock guard(m_mutex);
+				while (m_kernelHeld) {
+					guard.unlock();
+					const bool hasWaiters = m_waiters.HasWaiters();
+					guard.lock();
+
+					if (hasWaiters && m_kernelHeld && m_holders == 0) {
+						ReleaseKernelLock();
+					}
+					else {
+						m_revokeRequested = hasWaiters && m_kernelHeld;
+						m_stateChanged.wait_for(guard, RevocationDelay, [this] { return !m_kernelHeld; });
+					}
+				}
+				m_revokerRunning = false;
+			}
+
+			// Advanced in a fork()ed child, which marks every state created before the fork as inherited
+			static inline std::atomic<std::uint32_t> s_forkGeneration{ 0 };
+
+			std::mutex m_mutex{};
+			std::condition_variable_any m_stateChanged{};
+			std::unique_ptr<IFileLockStrategy> m_kernelLock{ nullptr };
+			WaiterSignal m_waiters; // Probed by the revoker thread only
+			std::uint32_t m_forkGeneration{ 0 };
+			bool m_kernelHeld{ false };
+			bool m_acquiring{ false }; // A thread of this process waits for the kernel lock outside m_mutex
+			bool m_revokeRequested{ false }; // Another process waits - the last holder releases the kernel lock
+			bool m_revokerRunning{ false };
+			std::uint32_t m_holders{ 0 };
+		};
+
+		/**
+		 * @brief Biased file locking strategy
+		 *
+		 * Lightweight handle on the process-wide BiasedLockState of a lock file. Unlike the platform strategies,
+		 * unlock() normally keeps the kernel lock so that the next lock() in this process is in-memory only.
+		 * Within one process the lock does not block, consistent with the platform strategies.
+		 */
+		class BiasedFileLock final : public IFileLockStrategy {
+		public:
+			explicit BiasedFileLock(BiasedLockState* state) noexcept :
+				m_state(state),
+				m_isLocked(false) {
+			}
+
+			~BiasedFileLock() noexcept override {
+				CleanupResources();
+			}
+
+			// Move constructor
+			BiasedFileLock(BiasedFileLock&& other) noexcept :
+				m_state(std::exchange(other.m_state, nullptr)),
+				m_isLocked(std::exchange(other.m_isLocked, false)) {
+			}
+
+			// Move assignment operator
+			BiasedFileLock& operator=(BiasedFileLock&& other) noexcept {
+				if (this != &other) {
+					CleanupResources();
+					m_state = std::exchange(other.m_state, nullptr);
+					m_isLocked = std::exchange(other.m_isLocked, false);
+				}
+				return *this;
+			}
+
+			[[nodiscard]] bool lock() noexcept override {
+				return Acquire([](IFileLockStrategy& kernelLock) { return ToStatus(kernelLock.lock()); }, false, std::nullopt, {}) == LockStatus::Acquired;
+			}
+
+			/**
+			 * @note Fails while another process keeps an idle bias - a single attempt does not raise the waiter
+			 * signal. Use a blocking or timed acquisition to revoke it.
+			 */
+			[[nodiscard]] bool try_lock() noexcept override {
+				return Acquire([](IFileLockStrategy& kernelLock) { return ToStatus(kernelLock.try_lock()); }, true, std::nullopt, {}) == LockStatus::Acquired;
+			}
+
+			[[nodiscard]] bool try_lock_for(std::chrono::milliseconds timeout) noexcept override {
+				const auto deadline = DeadlineAfter(timeout);
+				return Acquire([deadline](IFileLockStrategy& kernelLock) { return ToStatus(kernelLock.try_lock_for(Remaining(deadline))); }, false, deadline, {}) == LockStatus::Acquired;
+			}
+
+			/**
+			 * @note Cancellable both while waiting for the kernel lock and while queued behind another thread of this process
+			 */
+			[[nodiscard]] LockStatus lock(std::stop_token stopToken) noexcept override {
+				return Acquire([&stopToken](IFileLockStrategy& kernelLock) { return kernelLock.lock(stopToken); }, false, std::nullopt, stopToken);
+			}
+
+			[[nodiscard]] LockStatus try_lock_for(std::chrono::milliseconds timeout, std::stop_token stopToken) noexcept override {
+				const auto deadline = DeadlineAfter(timeout);
+				return Acquire([deadline, &stopToken](IFileLockStrategy& kernelLock) { return kernelLock.try_lock_for(Remaining(deadline), stopToken); }, false, deadline, stopToken);
+			}
+
+			void unlock() noexcept override {
+				CleanupResources();
+			}
+
+		private:
+			[[nodiscard]] static LockStatus ToStatus(bool acquired) noexcept {
+				return acquired ? LockStatus::Acquired : LockStatus::Failed;
+			}
+
+			[[nodiscard]] static std::chrono::milliseconds Remaining(std::chrono::steady_clock::time_point deadline) noexcept {
+				return std::max(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()), std::chrono::milliseconds(0));
+			}
+
+			[[nodiscard]] LockStatus Acquire(const std::function<LockStatus(IFileLockStrategy&)>& acquireKernelLock, bool nonBlocking, BiasedLockState::Deadline deadline, const std::stop_token& stopToken) noexcept {
+				if (m_isLocked) {
+					return LockStatus::Acquired;
+				}
+				if (!m_state) {
+					return LockStatus::Failed;
+				}
+
+				const LockStatus status = m_state->Acquire(acquireKernelLock, nonBlocking, deadline, stopToken);
+				m_isLocked = status == LockStatus::Acquired;
+				return status;
+			}
+
+			/**
+			* @brief Internal cleanup method - not virtual / CppCheck warning PVS-Studio/PC-Lint
+			*/
+			void CleanupResources() noexcept {
+				if (m_isLocked && m_state) {
+					m_state->Release();
+				}
+				m_isLocked = false;
+			}
+
+			BiasedLockState* m_state{ nullptr }; // Process-lifetime state, not owned
+			bool m_isLocked{ false };
+		};
+	} // namespace detail
+} // namespace file_lock
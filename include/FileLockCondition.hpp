@@ -0,0 +1,379 @@
+/*
+* @file FileLockCondition.hpp
+* @brief Condition variable tied to a lock file path
+* @author Kagan Can Sit
+*
+* Consumers that hold a FileLockContext on a shared state file can wait here until another process changes
+* the file (or explicitly signals it) instead of repeatedly locking, checking and sleeping. Waiting releases the
+* lock, sleeps until a change is observed and reacquires the lock before returning - the same contract as
+* std::condition_variable, only across processes.
+*
+* Change detection per platform:
+* - Linux: inotify watch on the lock file (IN_MODIFY, IN_ATTRIB, IN_DELETE_SELF, IN_MOVE_SELF)
+* - Windows: FindFirstChangeNotification on the parent directory, filtered by the file's last write time
+* - Other Unix (e.g. macOS): last write time polling with the same 10 ms interval as try_lock_for()
+*
+* Signalling (notify_all) updates the file timestamps. On Unix this deliberately uses utimensat() by path: opening
+* and closing another descriptor on the file would silently drop every fcntl() lock this process holds on it.
+*
+* @see https://man7.org/linux/man-pages/man7/inotify.7.html
+* @see https://learn.microsoft.com/en-us/windows/win32/api/fileapi/nf-fileapi-findfirstchangenotificationw
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#elif defined(__linux) || defined(__linux__)
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+#include "FileLockStrategy.hpp"
+
+namespace file_lock {
+	namespace detail {
+		/**
+		 * @brief Platform-specific observer for modifications of a single file
+		 *
+		 * Usage is always Arm() while the file lock is still held, then Wait() after the lock has been released.
+		 * Arming before the release closes the window in which a writer could modify the file unnoticed.
+		 */
+		class FileChangeWatcher final {
+		public:
+			using Deadline = std::optional<std::chrono::steady_clock::time_point>;
+
+			explicit FileChangeWatcher(const std::filesystem::path& file_path) noexcept : m_filePath(file_path) {
+#if defined(__linux) || defined(__linux__)
+				m_inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+			}
+
+			~FileChangeWatcher() noexcept {
+				CleanupResources();
+			}
+
+			/**
+			 * @brief Forgets changes seen so far and starts observing from now on
+			 * @return true if the watcher is ready, false if the platform facility could not be set up
+			 * @note Must be called while the caller still holds the file lock
+			 */
+			[[nodiscard]] bool Arm() noexcept {
+				std::error_code ec;
+				m_lastWriteTime = std::filesystem::last_write_time(m_filePath, ec);
+#if defined(_WIN32) || defined(_WIN64)
+				if (m_changeHandle != INVALID_HANDLE_VALUE) {
+					FindCloseChangeNotification(m_changeHandle);
+				}
+
+				const auto directory = m_filePath.has_parent_path() ? m_filePath.parent_path() : std::filesystem::path(L".");
+				m_changeHandle = FindFirstChangeNotificationW(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_FILE_NAME);
+				return m_changeHandle != INVALID_HANDLE_VALUE;
+#elif defined(__linux) || defined(__linux__)
+				if (m_inotifyDescriptor == -1) {
+					return false;
+				}
+
+				// Re-adding a watch for the same inode only updates its mask, so this also re-arms after IN_IGNORED
+				if (inotify_add_watch(m_inotifyDescriptor, m_filePath.c_str(), IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF) == -1) {
+					return false;
+				}
+
+				// Our own writes done under the lock are not a reason to wake up
+				DrainEvents();
+				return true;
+#else
+				return !ec;
+#endif
+			}
+
+			/**
+			 * @brief Sleeps until the file changes or the deadline passes
+			 * @param deadline Absolute wake-up time, std::nullopt to wait indefinitely
+			 * @return true if a change was observed, false on timeout or error
+			 */
+			[[nodiscard]] bool Wait(Deadline deadline) noexcept {
+#if defined(_WIN32) || defined(_WIN64)
+				if (m_changeHandle == INVALID_HANDLE_VALUE) {
+					return false;
+				}
+
+				// Directory notifications also fire for siblings, so confirm against the file's own timestamp
+				while (!HasWriteTimeChanged()) {
+					const DWORD waitTime = deadline ? static_cast<DWORD>(RemainingMilliseconds(*deadline, std::chrono::milliseconds(INFINITE - 1)).count()) : INFINITE;
+					const DWORD result = WaitForSingleObject(m_changeHandle, waitTime);
+					if (result == WAIT_TIMEOUT && std::chrono::steady_clock::now() < *deadline) {
+						continue; // Clamped wait time, the deadline is still ahead
+					}
+					if (result != WAIT_OBJECT_0) {
+						return HasWriteTimeChanged();
+					}
+					if (!FindNextChangeNotification(m_changeHandle)) {
+						return false;
+					}
+				}
+				return true;
+#elif defined(__linux) || defined(__linux__)
+				pollfd pollInfo = {
+					.fd = m_inotifyDescriptor,
+					.events = POLLIN,
+					.revents = 0
+				};
+
+				while (true) {
+					// poll() treats any negative timeout as infinite, so never let a long remaining time wrap around
+					const int waitTime = deadline ? static_cast<int>(RemainingMilliseconds(*deadline, std::chrono::milliseconds(std::numeric_limits<int>::max())).count()) : -1;
+					const int result = poll(&pollInfo, 1, waitTime);
+					if (result > 0) {
+						DrainEvents();
+						return true;
+					}
+
+					// Restart after signal interruption or a clamped timeout, give up on real errors or the deadline
+					if ((result == -1 && errno == EINTR) || (result == 0 && std::chrono::steady_clock::now() < *deadline)) {
+						continue;
+					}
+					return false;
+				}
+#else
+				while (!HasWriteTimeChanged()) {
+					auto sleep_time = std::chrono::milliseconds(10);
+					if (deadline) {
+						const auto remaining = RemainingMilliseconds(*deadline, sleep_time);
+						if (remaining.count() <= 0) {
+							return false;
+						}
+						sleep_time = remaining;
+					}
+					std::this_thread::sleep_for(sleep_time);
+				}
+				return true;
+#endif
+			}
+
+			/**
+			 * @brief Marks the file as changed so that every armed watcher wakes up
+			 * @param file_path Path to the watched file
+			 * @return true if the timestamps were updated
+			 * @note Does not open the file, so fcntl() locks held by the calling process stay intact
+			 */
+			[[nodiscard]] static bool Touch(const std::filesystem::path& file_path) noexcept {
+#if defined(_WIN32) || defined(_WIN64)
+				HANDLE fileHandle = CreateFileW(file_path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (fileHandle == INVALID_HANDLE_VALUE) {
+					return false;
+				}
+
+				FILETIME now{};
+				GetSystemTimeAsFileTime(&now);
+				const bool result = SetFileTime(fileHandle, nullptr, nullptr, &now) != FALSE;
+				CloseHandle(fileHandle);
+				return result;
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+				return utimensat(AT_FDCWD, file_path.c_str(), nullptr, 0) == 0;
+#else
+				(void)file_path;
+				return false;
+#endif
+			}
+
+			// Disable copy and move operations
+			FileChangeWatcher(const FileChangeWatcher&) = delete;
+			FileChangeWatcher& operator=(const FileChangeWatcher&) = delete;
+			FileChangeWatcher(FileChangeWatcher&&) = delete;
+			FileChangeWatcher& operator=(FileChangeWatcher&&) = delete;
+
+		private:
+			/**
+			 * @brief Time left until the deadline, rounded up and clamped to what the platform wait call accepts
+			 */
+			[[nodiscard]] static std::chrono::milliseconds RemainingMilliseconds(std::chrono::steady_clock::time_point deadline, std::chrono::milliseconds limit) noexcept {
+				const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+				return std::clamp(remaining, std::chrono::milliseconds(0), limit);
+			}
+
+			[[nodiscard]] bool HasWriteTimeChanged() const noexcept {
+				std::error_code ec;
+				const auto current = std::filesystem::last_write_time(m_filePath, ec);
+				return ec || current != m_lastWriteTime; // A vanished file counts as a change
+			}
+
+#if defined(__linux) || defined(__linux__)
+			void DrainEvents() noexcept {
+				alignas(inotify_event) char buffer[4096];
+				while (read(m_inotifyDescriptor, buffer, sizeof(buffer)) > 0) {
+				}
+			}
+#endif
+
+			/**
+			* @brief Internal cleanup method - not virtual / CppCheck warning PVS-Studio/PC-Lint
+			*/
+			void CleanupResources() noexcept {
+#if defined(_WIN32) || defined(_WIN64)
+				if (m_changeHandle != INVALID_HANDLE_VALUE) {
+					FindCloseChangeNotification(m_changeHandle);
+					m_changeHandle = INVALID_HANDLE_VALUE;
+				}
+#elif defined(__linux) || defined(__linux__)
+				if (m_inotifyDescriptor != -1) {
+					close(m_inotifyDescriptor);
+					m_inotifyDescriptor = -1;
+				}
+#endif
+			}
+
+			std::filesystem::path m_filePath{ "" };
+			std::filesystem::file_time_type m_lastWriteTime{};
+#if defined(_WIN32) || defined(_WIN64)
+			HANDLE m_changeHandle{ INVALID_HANDLE_VALUE };
+#elif defined(__linux) || defined(__linux__)
+			int m_inotifyDescriptor{ -1 };
+#endif
+		};
+	} // namespace detail
+
+	/**
+	 * @brief Cross-process condition variable bound to a lock file
+	 *
+	 * Waiters pass the FileLockContext they hold on the same file. The lock is released while sleeping and
+	 * reacquired (blocking) before any wait function returns, so the caller always owns the lock afterwards
+	 * unless IsLockAcquired() reports that reacquisition failed.
+	 *
+	 * Like std::condition_variable, wake-ups may be spurious - a change made by a process that does not use
+	 * notify_all() still wakes the waiters. Use the predicate overloads to re-check the actual state.
+	 *
+	 * Any number of threads may wait on the same condition at once: every wait call sets up its own watch, so
+	 * one waiter consuming change events never hides them from another.
+	 */
+	class FileLockCondition {
+	public:
+		/**
+		 * @brief Creates a condition bound to a lock file
+		 * @param file_path Path to the same file that the waiters lock
+		 */
+		explicit FileLockCondition(const std::filesystem::path& file_path) noexcept : m_filePath(file_path) {
+		}
+
+		/**
+		 * @brief Wakes up every process waiting on this file
+		 * @return true if the signal was delivered to the file system
+		 * @note May be called with or without holding the lock; holding it avoids waking waiters before the data is written
+		 */
+		bool notify_all() const noexcept {
+			return detail::FileChangeWatcher::Touch(m_filePath);
+		}
+
+		/**
+		 * @brief Releases the lock, waits for a change and reacquires the lock
+		 * @param context Locked context on the condition's file
+		 * @return true if a change was observed, false if waiting was not possible
+		 * @note Check IsLockAcquired() afterwards - it is false if the lock could not be reacquired
+		 */
+		bool wait(FileLockContext& context) noexcept {
+			return WaitInternal(context, std::nullopt);
+		}
+
+		/**
+		 * @brief Waits until the predicate holds, re-checking it after every wake-up
+		 * @param context Locked context on the condition's file
+		 * @param predicate Condition evaluated while the lock is held
+		 * @return true once the predicate holds, false if waiting was not possible or the lock could not be reacquired
+		 * @note The predicate is never evaluated without the lock
+		 */
+		template <typename Predicate>
+		[[nodiscard]] bool wait(FileLockContext& context, Predicate predicate) {
+			if (!context.m_isLocked) {
+				return false;
+			}
+			while (!predicate()) {
+				if (!wait(context) || !context.m_isLocked) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Like wait(), but gives up after the timeout
+		 * @param context Locked context on the condition's file
+		 * @param timeout Maximum time to sleep - lock reacquisition afterwards is not included
+		 * @return true if a change was observed, false on timeout or error
+		 */
+		bool wait_for(FileLockContext& context, std::chrono::milliseconds timeout) noexcept {
+			return WaitInternal(context, detail::DeadlineAfter(timeout));
+		}
+
+		/**
+		 * @brief Waits until the predicate holds or the timeout expires
+		 * @param context Locked context on the condition's file
+		 * @param timeout Maximum total time to sleep
+		 * @param predicate Condition evaluated while the lock is held
+		 * @return Final result of the predicate, false if the lock could not be reacquired
+		 * @note The predicate is never evaluated without the lock
+		 */
+		template <typename Predicate>
+		[[nodiscard]] bool wait_for(FileLockContext& context, std::chrono::milliseconds timeout, Predicate predicate) {
+			if (!context.m_isLocked) {
+				return false;
+			}
+
+			const auto deadline = detail::DeadlineAfter(timeout);
+			while (!predicate()) {
+				const bool changed = WaitInternal(context, deadline);
+				if (!context.m_isLocked) {
+					return false;
+				}
+				if (!changed) {
+					return predicate();
+				}
+			}
+			return true;
+		}
+
+		// Disable copy and move operations
+		FileLockCondition(const FileLockCondition&) = delete;
+		FileLockCondition& operator=(const FileLockCondition&) = delete;
+		FileLockCondition(FileLockCondition&&) = delete;
+		FileLockCondition& operator=(FileLockCondition&&) = delete;
+
+	private:
+		bool WaitInternal(FileLockContext& context, detail::FileChangeWatcher::Deadline deadline) noexcept {
+			if (!context.m_strategy || !context.m_isLocked) {
+				return false;
+			}
+
+			// Arm while still holding the lock so a writer cannot slip in between release and sleep
+			detail::FileChangeWatcher watcher(m_filePath);
+			if (!watcher.Arm()) {
+				return false;
+			}
+
+			context.m_strategy->unlock();
+			context.m_isLocked = false;
+
+			const bool changed = watcher.Wait(deadline);
+
+			context.m_isLocked = context.m_strategy->lock();
+			return changed;
+		}
+
+		std::filesystem::path m_filePath{ "" };
+	};
+} // namespace file_lock
@@ -0,0 +1,449 @@
+/*
+* @file FileLockElection.hpp
+* @brief Leader election / hot-standby built on top of the file lock strategies
+* @author Kagan Can Sit
+*
+* The process that holds the exclusive lock on a well-known file is the leader. Standby processes campaign for
+* the same lock and take over as soon as the kernel releases it, which happens immediately when the leader
+* resigns, exits or is killed - no heartbeat or lease timeout is involved.
+*
+* The optional leader identity record (PID and leadership start time) is stored in a sidecar file next to the
+* lock file ("<lock file>.leader"). It is not written into the lock file itself because Windows refuses reads of
+* a region locked by another process, and on Unix any extra descriptor closed on the lock file would drop the
+* leader's fcntl() lock.
+*
+* A leader also watches the lock file itself. If it is deleted or replaced, new candidates lock a different file
+* and would be elected alongside it, so the leader steps down as soon as it notices (LeadershipCheckInterval).
+*
+* @warning Only one LeaderElection per lock file per process - within a process the underlying locks do not block.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FileLockFactory.hpp"
+
+namespace file_lock {
+	/**
+	 * @brief Identity of the current leader as stored in the sidecar record file
+	 */
+	struct LeaderRecord {
+		std::int64_t pid{ 0 };
+		std::chrono::system_clock::time_point since{};
+	};
+
+	/**
+	 * @brief Leadership change notifications for LeaderElection
+	 */
+	struct LeaderCallbacks {
+		std::function<void()> onElected{};        // This process became the leader
+		std::function<void()> onLostLeadership{}; // This process stopped being the leader - resigned, destroyed or lock file replaced
+	};
+
+	/**
+	 * @brief Single-active-instance election over an exclusive file lock
+	 *
+	 * Leadership lasts from a successful campaign until Resign(), destruction or the loss of the lock file
+	 * (deleted or replaced by another file). Callbacks are invoked without internal locks held; for
+	 * CampaignAsync() they run on the background campaign thread, for a lost lock file on the monitor thread.
+	 *
+	 * At most one campaign runs at a time. Two lock contexts on the same file in one process would both
+	 * succeed, and closing either one drops the process's only fcntl() lock - so a second campaign is refused.
+	 *
+	 * Exceptions thrown by a callback propagate out of the campaign or Resign() call that triggered it, after
+	 * the leadership state has been updated. On the background campaign and monitor threads and in the
+	 * destructor they are swallowed.
+	 */
+	class LeaderElection {
+	public:
+		/**
+		 * @brief Creates an election participant
+		 * @param file_path Well-known lock file shared by all candidates
+		 * @param callbacks Leadership change notifications
+		 * @param writeRecord Whether the leader publishes its LeaderRecord next to the lock file
+		 */
+		explicit LeaderElection(const std::filesystem::path& file_path, LeaderCallbacks callbacks = {}, bool writeRecord = true) noexcept
+			: m_filePath(file_path), m_callbacks(std::move(callbacks)), m_writeRecord(writeRecord) {
+		}
+
+		/**
+		 * @brief Steps down (if leader) and stops any background campaign
+		 */
+		~LeaderElection() noexcept {
+			try {
+				Resign();
+			}
+			catch (...) {
+				// onLostLeadership threw - leadership is already released, nothing left to undo
+			}
+		}
+
+		/**
+		 * @brief Campaigns with BLOCKING acquisition - returns once this process is the leader
+		 * @return true if elected, false on error or while another campaign (e.g. CampaignAsync) is running
+		 */
+		[[nodiscard]] bool Campaign() {
+			return CampaignInternal([this] { return FileLockFactory::CreateLockContext(m_filePath); });
+		}
+
+		/**
+		 * @brief Campaigns with NON-BLOCKING acquisition
+		 * @return true if elected, false if another process is the leader or another campaign is running
+		 */
+		[[nodiscard]] bool TryCampaign() {
+			return CampaignInternal([this] { return FileLockFactory::CreateTryLockContext(m_filePath); });
+		}
+
+		/**
+		 * @brief Campaigns with TIMEOUT-BASED acquisition
+		 * @param timeout Maximum time to wait for leadership
+		 * @return true if elected within the timeout, false otherwise or while another campaign is running
+		 */
+		[[nodiscard]] bool CampaignFor(std::chrono::milliseconds timeout) {
+			return CampaignInternal([this, timeout] { return FileLockFactory::CreateTimedLockContext(m_filePath, timeout); });
+		}
+
+		/**
+		 * @brief Campaigns in a background thread and returns immediately
+		 *
+		 * The thread keeps waiting as a hot standby until elected or until Resign() is called. Leadership
+		 * is reported through LeaderCallbacks::onElected.
+		 */
+		void CampaignAsync() {
+			std::lock_guard guard(m_mutex);
+			if (m_context || m_campaigning) {
+				return;
+			}
+
+			m_campaigning = true;
+			m_campaignThread = std::jthread([this](std::stop_token stopToken) {
+				while (!stopToken.stop_requested()) {
+					auto [context, status] = FileLockFactory::CreateLockContext(m_filePath, stopToken);
+					if (context) {
+						try {
+							BecomeLeader(std::move(context));
+						}
+						catch (...) {
+							// onElected threw - leadership is already taken, keep it
+						}
+						return;
+					}
+
+					// Open or lock error - retry instead of giving up the standby role
+					if (status == LockStatus::Cancelled || !detail::InterruptibleSleep(CampaignRetryDelay, stopToken)) {
+						break;
+					}
+				}
+				EndCampaign();
+			});
+		}
+
+		/**
+		 * @brief Voluntarily gives up leadership and stops a pending background campaign
+		 */
+		void Resign() {
+			std::jthread campaignThread;
+			{
+				std::lock_guard guard(m_mutex);
+				campaignThread = std::move(m_campaignThread);
+			}
+
+			// Stop the campaign first, it may be about to win
+			StopThread(campaignThread);
+
+			std::jthread monitorThread;
+			std::unique_ptr<FileLockContext> context;
+			{
+				std::lock_guard guard(m_mutex);
+				monitorThread = std::move(m_monitorThread);
+				context = std::move(m_context);
+				m_record.reset();
+			}
+			StopThread(monitorThread);
+
+			if (context) {
+				// Remove the record before unlocking so the next leader's record is never deleted
+				if (m_writeRecord) {
+					std::error_code ec;
+					std::filesystem::remove(RecordPath(m_filePath), ec);
+				}
+				context.reset();
+
+				if (m_callbacks.onLostLeadership) {
+					m_callbacks.onLostLeadership();
+				}
+			}
+		}
+
+		/**
+		 * @brief Returns whether this process currently holds leadership
+		 */
+		[[nodiscard]] bool IsLeader() const noexcept {
+			std::lock_guard guard(m_mutex);
+			return m_context != nullptr;
+		}
+
+		/**
+		 * @brief Returns the identity of the current leader
+		 * @return Own record while leader, otherwise the published record (std::nullopt if none)
+		 * @note A leader that was killed leaves its record behind until the next leader overwrites it
+		 */
+		[[nodiscard]] std::optional<LeaderRecord> GetLeader() const {
+			{
+				std::lock_guard guard(m_mutex);
+				if (m_context) {
+					return m_record;
+				}
+			}
+			return ReadLeaderRecord(m_filePath);
+		}
+
+		/**
+		 * @brief Reads the leader record published for a lock file
+		 * @param file_path Election lock file
+		 * @return Published record, or std::nullopt if none exists or it cannot be parsed
+		 */
+		[[nodiscard]] static std::optional<LeaderRecord> ReadLeaderRecord(const std::filesystem::path& file_path) {
+			std::ifstream input(RecordPath(file_path));
+			std::int64_t pid = 0;
+			std::int64_t sinceMs = 0;
+			if (!(input >> pid >> sinceMs)) {
+				return std::nullopt;
+			}
+			return LeaderRecord{ pid, std::chrono::system_clock::time_point(std::chrono::milliseconds(sinceMs)) };
+		}
+
+		// Disable copy and move operations
+		LeaderElection(const LeaderElection&) = delete;
+		LeaderElection& operator=(const LeaderElection&) = delete;
+		LeaderElection(LeaderElection&&) = delete;
+		LeaderElection& operator=(LeaderElection&&) = delete;
+
+	private:
+		// Pause before a background campaign retries after an open or lock error
+		static constexpr std::chrono::milliseconds CampaignRetryDelay{ 100 };
+
+		// How often a leader checks that its lock file is still the one at the well-known path
+		static constexpr std::chrono::milliseconds LeadershipCheckInterval{ 100 };
+
+		/**
+		 * @brief Identifies a file independently of its path (device and inode / volume and file index)
+		 */
+		struct FileIdentity {
+			std::uint64_t device{ 0 };
+			std::uint64_t index{ 0 };
+
+			[[nodiscard]] bool operator==(const FileIdentity&) const noexcept = default;
+		};
+
+		/**
+		 * @brief Reads the identity of the file currently at the path
+		 * @return Identity, or std::nullopt if the file does not exist or cannot be inspected
+		 * @note Never opens the file on Unix, so the fcntl() lock held on it stays intact
+		 */
+		[[nodiscard]] static std::optional<FileIdentity> ReadFileIdentity(const std::filesystem::path& file_path) noexcept {
+#if defined(_WIN32) || defined(_WIN64)
+			// No access rights requested - only metadata is read, and LockFileEx() locks belong to the other handle
+			HANDLE fileHandle = CreateFileW(file_path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (fileHandle == INVALID_HANDLE_VALUE) {
+				return std::nullopt;
+			}
+
+			BY_HANDLE_FILE_INFORMATION fileInfo{};
+			const bool result = GetFileInformationByHandle(fileHandle, &fileInfo) != FALSE;
+			CloseHandle(fileHandle);
+			if (!result) {
+				return std::nullopt;
+			}
+			return FileIdentity{ fileInfo.dwVolumeSerialNumber, (static_cast<std::uint64_t>(fileInfo.nFileIndexHigh) << 32) | fileInfo.nFileIndexLow };
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+			struct stat fileInfo {};
+			if (stat(file_path.c_str(), &fileInfo) != 0) {
+				return std::nullopt;
+			}
+			return FileIdentity{ static_cast<std::uint64_t>(fileInfo.st_dev), static_cast<std::uint64_t>(fileInfo.st_ino) };
+#else
+			(void)file_path;
+			return std::nullopt;
+#endif
+		}
+
+		/**
+		 * @brief Requests a stop and joins, or detaches if called from the thread itself (e.g. from a callback)
+		 */
+		static void StopThread(std::jthread& thread) {
+			thread.request_stop();
+			if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+				thread.join();
+			}
+			else if (thread.joinable()) {
+				thread.detach();
+			}
+		}
+
+		[[nodiscard]] static std::filesystem::path RecordPath(const std::filesystem::path& file_path) {
+			auto recordPath = file_path;
+			recordPath += ".leader";
+			return recordPath;
+		}
+
+		/**
+		 * @brief Runs one synchronous acquisition unless already leader or another campaign is running
+		 * @param acquire Factory call producing the lock context (nullptr if not acquired)
+		 */
+		template <typename Acquire>
+		[[nodiscard]] bool CampaignInternal(Acquire acquire) {
+			{
+				std::lock_guard guard(m_mutex);
+				if (m_context) {
+					return true;
+				}
+				if (m_campaigning) {
+					return false; // Never open a second context on the same file in this process
+				}
+				m_campaigning = true;
+			}
+
+			auto context = acquire();
+			if (!context) {
+				EndCampaign();
+				return false;
+			}
+			return BecomeLeader(std::move(context));
+		}
+
+		void EndCampaign() noexcept {
+			std::lock_guard guard(m_mutex);
+			m_campaigning = false;
+		}
+
+		[[nodiscard]] static std::int64_t CurrentProcessId() noexcept {
+#if defined(_WIN32) || defined(_WIN64)
+			return static_cast<std::int64_t>(GetCurrentProcessId());
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+			return static_cast<std::int64_t>(getpid());
+#else
+			return 0;
+#endif
+		}
+
+		/**
+		 * @brief Writes the record to a temporary file and renames it into place, so readers never see a partial one
+		 * @note Sidecar files - closing them does not affect the lock held on the election file
+		 */
+		void WriteRecord(const LeaderRecord& record) const {
+			const auto recordPath = RecordPath(m_filePath);
+			auto tempPath = recordPath;
+			tempPath += ".tmp." + std::to_string(record.pid);
+			{
+				std::ofstream output(tempPath, std::ios::trunc);
+				output << record.pid << ' '
+					<< std::chrono::duration_cast<std::chrono::milliseconds>(record.since.time_since_epoch()).count() << '\n';
+				if (!output.flush()) {
+					return;
+				}
+			}
+
+			std::error_code ec;
+			std::filesystem::rename(tempPath, recordPath, ec);
+			if (ec) {
+				std::filesystem::remove(tempPath, ec);
+			}
+		}
+
+		/**
+		 * @brief Takes ownership of a freshly acquired lock, ends the running campaign and announces leadership
+		 * @param context Lock context acquired by the campaign that is currently running
+		 * @return true - this process is now the leader
+		 * @note Only the single running campaign calls this, so there is never an existing context to replace
+		 */
+		bool BecomeLeader(std::unique_ptr<FileLockContext> context) {
+			LeaderRecord record{ CurrentProcessId(), std::chrono::system_clock::now() };
+			const auto identity = ReadFileIdentity(m_filePath);
+			if (m_writeRecord) {
+				WriteRecord(record);
+			}
+
+			std::jthread previousMonitor;
+			{
+				std::lock_guard guard(m_mutex);
+				m_context = std::move(context);
+				m_record = record;
+				m_campaigning = false;
+				previousMonitor = std::move(m_monitorThread);
+				m_monitorThread = std::jthread([this, identity](std::stop_token stopToken) { MonitorLeadership(identity, stopToken); });
+			}
+			StopThread(previousMonitor); // Monitor of an earlier term that already reported its loss
+
+			if (m_callbacks.onElected) {
+				m_callbacks.onElected();
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Steps down once the lock file at the path is no longer the one this process has locked
+		 * @param identity Identity of the locked file, read right after the election
+		 * @param stopToken Stopped by Resign() or a new term
+		 */
+		void MonitorLeadership(std::optional<FileIdentity> identity, const std::stop_token& stopToken) noexcept {
+			while (detail::InterruptibleSleep(LeadershipCheckInterval, stopToken)) {
+				if (identity && ReadFileIdentity(m_filePath) == identity) {
+					continue;
+				}
+
+				std::unique_ptr<FileLockContext> context;
+				{
+					std::lock_guard guard(m_mutex);
+					context = std::move(m_context);
+					m_record.reset();
+				}
+
+				// The record now belongs to whoever locked the new file - leave it alone
+				if (context) {
+					context.reset();
+					try {
+						if (m_callbacks.onLostLeadership) {
+							m_callbacks.onLostLeadership();
+						}
+					}
+					catch (...) {
+						// onLostLeadership threw - leadership is already released, nothing left to undo
+					}
+				}
+				return;
+			}
+		}
+
+		std::filesystem::path m_filePath{ "" };
+		LeaderCallbacks m_callbacks{};
+		bool m_writeRecord{ true };
+
+		mutable std::mutex m_mutex{};
+		std::unique_ptr<FileLockContext> m_context{ nullptr };
+		std::optional<LeaderRecord> m_record{};
+		bool m_campaigning{ false }; // An acquisition is in flight - guards against a second context on the file
+		std::jthread m_campaignThread{};
+		std::jthread m_monitorThread{}; // Runs while leader, watches for a deleted or replaced lock file
+	};
+} // namespace file_lock
@@ -11,12 +11,32 @@
 #include <chrono>
 #include <filesystem>
 #include <memory>
+#include <stop_token>
 
+#include "BiasedFileLock.hpp"
 #include "FileLockStrategy.hpp"
 #include "UnixFileLock.hpp"
 #include "WindowsFileLock.hpp"
 
 namespace file_lock {
+	/**
+	 * @brief Result of a cancellable factory method
+	 *
+	 * Unlike the plain factory methods, which only return nullptr on failure, this tells a cancelled wait apart
+	 * from a timeout or an error. Supports structured bindings: auto [lock, status] = ...
+	 */
+	struct LockResult {
+		std::unique_ptr<FileLockContext> context{ nullptr }; // Lock context, nullptr unless status is Acquired
+		LockStatus status{ LockStatus::Failed };
+
+		/**
+		 * @brief Check if the lock was acquired
+		 */
+		[[nodiscard]] explicit operator bool() const noexcept {
+			return status == LockStatus::Acquired;
+		}
+	};
+
 	class FileLockFactory {
 	public:
 		/**
@@ -31,13 +51,37 @@ namespace file_lock {
 		 * @return Unique pointer to file lock context, or nullptr if unsupported platform
 		 */
 		[[nodiscard]] static std::unique_ptr<FileLockContext> CreateLockContext(const std::filesystem::path& file_path) noexcept {
-			auto strategy = CreateStrategyInternal(file_path);
+			auto strategy = CreatePlainStrategyInternal(file_path);
 			if (!strategy || !strategy->lock()) {
 				return nullptr;
 			}
 			return std::make_unique<FileLockContext>(std::move(strategy), true); // already lock
 		}
 
+		/**
+		 * @brief Creates a file lock context with CANCELLABLE BLOCKING acquisition
+		 * Uses strategy->lock(stopToken) internally - waits until lock is available or a stop is requested
+		 *
+		 * Intended for worker threads (e.g. std::jthread) that must not stay stuck on a lock held by another
+		 * process during shutdown. A stop request ends the wait within milliseconds and releases the open file.
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @param stopToken Token that cancels the wait
+		 * @return Lock context and LockStatus::Acquired, LockStatus::Failed or LockStatus::Cancelled
+		 */
+		[[nodiscard]] static LockResult CreateLockContext(const std::filesystem::path& file_path, std::stop_token stopToken) noexcept {
+			auto strategy = CreatePlainStrategyInternal(file_path);
+			if (!strategy) {
+				return {};
+			}
+
+			const LockStatus status = strategy->lock(std::move(stopToken));
+			if (status != LockStatus::Acquired) {
+				return { nullptr, status };
+			}
+			return { std::make_unique<FileLockContext>(std::move(strategy), true), status }; // already locked
+		}
+
 		/**
 		 * @brief Creates a file lock context with NON-BLOCKING acquisition
 		 * Uses strategy->try_lock() internally - fails immediately if locked
@@ -50,7 +94,7 @@ namespace file_lock {
 		 * @return Unique pointer to file lock context, or nullptr if unsupported platform
 		 */
 		[[nodiscard]] static std::unique_ptr<FileLockContext> CreateTryLockContext(const std::filesystem::path& file_path) noexcept {
-			auto strategy = CreateStrategyInternal(file_path);
+			auto strategy = CreatePlainStrategyInternal(file_path);
 			if (!strategy || !strategy->try_lock()) {
 				return nullptr;
 			}
@@ -69,14 +113,166 @@ namespace file_lock {
 		 * @return Unique pointer to file lock context, or nullptr if unsupported platform or lock failed
 		 */
 		[[nodiscard]] static std::unique_ptr<FileLockContext> CreateTimedLockContext(const std::filesystem::path& file_path, std::chrono::milliseconds timeout) noexcept {
-			auto strategy = CreateStrategyInternal(file_path);
+			auto strategy = CreatePlainStrategyInternal(file_path);
+			if (!strategy || !strategy->try_lock_for(timeout)) {
+				return nullptr;
+			}
+			return std::make_unique<FileLockContext>(std::move(strategy), true); // already locked
+		}
+
+		/**
+		 * @brief Creates a file lock context with CANCELLABLE TIMEOUT-BASED acquisition
+		 * Uses strategy->try_lock_for(timeout, stopToken) internally - waits up to timeout or until a stop is requested
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @param timeout Maximum time to wait for lock acquisition
+		 * @param stopToken Token that cancels the wait
+		 * @return Lock context and LockStatus::Acquired, LockStatus::Failed, LockStatus::TimedOut or LockStatus::Cancelled
+		 */
+		[[nodiscard]] static LockResult CreateTimedLockContext(const std::filesystem::path& file_path, std::chrono::milliseconds timeout, std::stop_token stopToken) noexcept {
+			auto strategy = CreatePlainStrategyInternal(file_path);
+			if (!strategy) {
+				return {};
+			}
+
+			const LockStatus status = strategy->try_lock_for(timeout, std::move(stopToken));
+			if (status != LockStatus::Acquired) {
+				return { nullptr, status };
+			}
+			return { std::make_unique<FileLockContext>(std::move(strategy), true), status }; // already locked
+		}
+
+		/**
+		 * @brief Creates a file lock context with BIASED BLOCKING acquisition
+		 * Uses the biased strategy - releasing the context keeps the kernel lock for this process
+		 *
+		 * Intended for lock files that are almost always used by one process. While no other process waits,
+		 * repeated acquisitions in this process are purely in-memory. Another process that waits in any
+		 * blocking or timed factory method (plain or biased) revokes the bias and gets the lock within
+		 * BiasedLockState::RevocationDelay once this process no longer uses it.
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @return Unique pointer to file lock context, or nullptr if unsupported platform or lock failed
+		 */
+		[[nodiscard]] static std::unique_ptr<FileLockContext> CreateBiasedLockContext(const std::filesystem::path& file_path) noexcept {
+			auto strategy = CreateBiasedStrategyInternal(file_path);
+			if (!strategy || !strategy->lock()) {
+				return nullptr;
+			}
+			return std::make_unique<FileLockContext>(std::move(strategy), true); // already locked
+		}
+
+		/**
+		 * @brief Creates a file lock context with BIASED CANCELLABLE BLOCKING acquisition
+		 * Uses the biased strategy's lock(stopToken) - revokes a foreign bias and waits until acquired or cancelled
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @param stopToken Token that cancels the wait
+		 * @return Lock context and LockStatus::Acquired, LockStatus::Failed or LockStatus::Cancelled
+		 */
+		[[nodiscard]] static LockResult CreateBiasedLockContext(const std::filesystem::path& file_path, std::stop_token stopToken) noexcept {
+			auto strategy = CreateBiasedStrategyInternal(file_path);
+			if (!strategy) {
+				return {};
+			}
+
+			const LockStatus status = strategy->lock(std::move(stopToken));
+			if (status != LockStatus::Acquired) {
+				return { nullptr, status };
+			}
+			return { std::make_unique<FileLockContext>(std::move(strategy), true), status }; // already locked
+		}
+
+		/**
+		 * @brief Creates a file lock context with BIASED NON-BLOCKING acquisition
+		 * Uses the biased strategy's try_lock() - fails immediately if another process holds the lock
+		 *
+		 * This includes an idle bias kept by another process: a single attempt does not raise the waiter signal,
+		 * so it cannot revoke it. Use the blocking or timed methods to take the lock over. Also fails immediately while another thread of this process acquires the lock.
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @return Unique pointer to file lock context, or nullptr if unsupported platform or lock failed
+		 */
+		[[nodiscard]] static std::unique_ptr<FileLockContext> CreateBiasedTryLockContext(const std::filesystem::path& file_path) noexcept {
+			auto strategy = CreateBiasedStrategyInternal(file_path);
+			if (!strategy || !strategy->try_lock()) {
+				return nullptr;
+			}
+			return std::make_unique<FileLockContext>(std::move(strategy), true); // already locked
+		}
+
+		/**
+		 * @brief Creates a file lock context with BIASED TIMEOUT-BASED acquisition
+		 * Uses the biased strategy's try_lock_for() - revokes a foreign bias and waits up to timeout
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @param timeout Maximum time to wait for lock acquisition
+		 * @return Unique pointer to file lock context, or nullptr if unsupported platform or lock failed
+		 */
+		[[nodiscard]] static std::unique_ptr<FileLockContext> CreateBiasedTimedLockContext(const std::filesystem::path& file_path, std::chrono::milliseconds timeout) noexcept {
+			auto strategy = CreateBiasedStrategyInternal(file_path);
 			if (!strategy || !strategy->try_lock_for(timeout)) {
 				return nullptr;
 			}
 			return std::make_unique<FileLockContext>(std::move(strategy), true); // already locked
 		}
 
+		/**
+		 * @brief Creates a file lock context with BIASED CANCELLABLE TIMEOUT-BASED acquisition
+		 * Uses the biased strategy's try_lock_for(timeout, stopToken) - revokes a foreign bias and waits up to timeout
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @param timeout Maximum time to wait for lock acquisition
+		 * @param stopToken Token that cancels the wait
+		 * @return Lock context and LockStatus::Acquired, LockStatus::Failed, LockStatus::TimedOut or LockStatus::Cancelled
+		 */
+		[[nodiscard]] static LockResult CreateBiasedTimedLockContext(const std::filesystem::path& file_path, std::chrono::milliseconds timeout, std::stop_token stopToken) noexcept {
+			auto strategy = CreateBiasedStrategyInternal(file_path);
+			if (!strategy) {
+				return {};
+			}
+
+			const LockStatus status = strategy->try_lock_for(timeout, std::move(stopToken));
+			if (status != LockStatus::Acquired) {
+				return { nullptr, status };
+			}
+			return { std::make_unique<FileLockContext>(std::move(strategy), true), status }; // already locked
+		}
+
 	private:
+		/**
+		 * @brief Internal method to create a platform-specific strategy for the plain factory methods
+		 *
+		 * Refuses paths that this process has used in biased mode: closing a plain lock would silently drop the
+		 * fcntl() lock that the biased state relies on.
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @return Unique pointer to platform-specific strategy, or nullptr if unsupported or in biased use
+		 */
+		[[nodiscard]] static std::unique_ptr<detail::IFileLockStrategy> CreatePlainStrategyInternal(const std::filesystem::path& file_path) noexcept {
+			if (detail::BiasedLockState::IsActive(file_path)) {
+				return nullptr;
+			}
+			return CreateStrategyInternal(file_path);
+		}
+
+		/**
+		 * @brief Internal method to create a biased strategy on top of the platform-specific one
+		 *
+		 * All biased strategies for the same path share one process-wide state holding the platform strategy,
+		 * created on first use and kept until the process exits.
+		 *
+		 * @param file_path Path to the file to be locked
+		 * @return Unique pointer to biased strategy, or nullptr if unsupported
+		 */
+		[[nodiscard]] static std::unique_ptr<detail::IFileLockStrategy> CreateBiasedStrategyInternal(const std::filesystem::path& file_path) noexcept {
+			auto state = detail::BiasedLockState::Get(file_path, [&file_path] { return CreateStrategyInternal(file_path); });
+			if (!state) {
+				return nullptr;
+			}
+			return std::make_unique<detail::BiasedFileLock>(state);
+		}
+
 		/**
 		 * @brief Internal method to create platform-specific strategy
 		 *
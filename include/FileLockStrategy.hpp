@@ -10,15 +10,62 @@
 #pragma once
 
 #include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <stop_token>
 #include <utility>
 
 namespace file_lock {
 
 	class FileLockContext; // Forward declaration
+	class FileLockCondition; // Forward declaration
+
+	/**
+	 * @brief Outcome of a cancellable lock acquisition
+	 */
+	enum class LockStatus {
+		Acquired,  // Lock is held
+		Failed,    // File could not be opened or locked
+		TimedOut,  // Timeout expired before the lock became available
+		Cancelled  // Stop was requested on the std::stop_token while waiting
+	};
 
 	namespace detail {
+		// Polling interval shared by the platform strategies while waiting for a lock held by another process
+		inline constexpr std::chrono::milliseconds LockPollInterval{ 10 };
+
+		/**
+		 * @brief Converts a timeout into an absolute deadline without overflowing the clock
+		 * @param timeout Relative timeout - std::chrono::milliseconds::max() effectively means "no limit"
+		 * @return now() + timeout, saturated to the latest representable time point
+		 */
+		[[nodiscard]] inline std::chrono::steady_clock::time_point DeadlineAfter(std::chrono::milliseconds timeout) noexcept {
+			const auto now = std::chrono::steady_clock::now();
+			if (timeout <= std::chrono::milliseconds::zero()) {
+				return now;
+			}
+			if (timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::time_point::max() - now)) {
+				return std::chrono::steady_clock::time_point::max();
+			}
+			return now + timeout;
+		}
+
+		/**
+		 * @brief Sleeps for the given duration unless a stop is requested
+		 * @param duration Time to sleep
+		 * @param stopToken Token that interrupts the sleep immediately
+		 * @return false if a stop was requested, true otherwise
+		 */
+		[[nodiscard]] inline bool InterruptibleSleep(std::chrono::milliseconds duration, const std::stop_token& stopToken) noexcept {
+			std::mutex sleepMutex;
+			std::condition_variable_any sleepCondition;
+			std::unique_lock guard(sleepMutex);
+			sleepCondition.wait_for(guard, stopToken, duration, [] { return false; });
+			return !stopToken.stop_requested();
+		}
+
 		class IFileLockStrategy {
 		public:
 			/**
@@ -49,6 +96,22 @@ namespace file_lock {
 			*/
 			[[nodiscard]] virtual bool try_lock_for(std::chrono::milliseconds timeout) noexcept = 0;
 
+			/**
+			* @brief Attempts to acquire an exclusive lock on the file until it succeeds or a stop is requested
+			* @param stopToken Token that cancels the wait
+			* @return LockStatus::Acquired, LockStatus::Failed or LockStatus::Cancelled
+			* @note This is a blocking call - with a token that can never be stopped it behaves like lock()
+			*/
+			[[nodiscard]] virtual LockStatus lock(std::stop_token stopToken) noexcept = 0;
+
+			/**
+			* @brief Attempts to acquire an exclusive lock on the file with timeout until a stop is requested
+			* @param timeout Maximum time to wait for lock acquisition
+			* @param stopToken Token that cancels the wait
+			* @return LockStatus::Acquired, LockStatus::Failed, LockStatus::TimedOut or LockStatus::Cancelled
+			*/
+			[[nodiscard]] virtual LockStatus try_lock_for(std::chrono::milliseconds timeout, std::stop_token stopToken) noexcept = 0;
+
 			/**
 			 * @brief Releases the file lock
 			 */
@@ -106,7 +169,7 @@ namespace file_lock {
 		/**
 		* @brief Returns whether lock acquisition was successful
 		* @return true if lock was acquired successfully during construction
-		* @note This only indicates initial lock success, not current state
+		* @note This only indicates initial lock success, or the reacquisition result after a FileLockCondition wait
 		*/
 		[[nodiscard]] bool IsLockAcquired() const noexcept {
 			return m_isLocked;
@@ -140,6 +203,8 @@ namespace file_lock {
 		}
 
 	private:
+		friend class FileLockCondition; // Releases and reacquires the lock while waiting
+
 		std::unique_ptr<detail::IFileLockStrategy> m_strategy{ nullptr };
 		bool m_isLocked{ false };
 	};
@@ -0,0 +1,167 @@
+/*
+* @file FileLockWaiters.hpp
+* @brief Cross-process "someone is waiting for this lock file" signal
+* @author Kagan Can Sit
+*
+* A process that has to wait for a lock file takes a shared lock on a small sidecar file ("<lock file>.waiters")
+* for the duration of the wait. A process that keeps a lock without using it (see BiasedFileLock.hpp) probes the
+* sidecar for such locks and gives its lock away when it finds one.
+*
+* The signal is a kernel lock rather than a value stored in the file, so it disappears together with the waiter:
+* a contender that is killed or interrupted (e.g. Ctrl-C) can never leave it raised.
+*
+* @see https://man7.org/linux/man-pages/man2/fcntl.2.html
+* @see https://learn.microsoft.com/en-us/windows/win32/api/fileapi/nf-fileapi-lockfileex
+*/
+
+#pragma once
+
+#include <filesystem>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace file_lock {
+	namespace detail {
+		/**
+		 * @brief Waiter signal of one lock file, kept in the "<lock file>.waiters" sidecar
+		 *
+		 * Only the first byte of the sidecar is locked; the file itself stays empty. Being a separate file,
+		 * closing its descriptor never touches the fcntl() lock on the lock file.
+		 *
+		 * @note fcntl() locks belong to the process: within one process only one waiter per lock file may raise
+		 * the signal at a time, and HasWaiters() never reports the calling process itself.
+		 */
+		class WaiterSignal final {
+		public:
+			/**
+			 * @brief Opens the sidecar of a lock file
+			 * @param file_path Path to the lock file
+			 * @param create Create the sidecar if missing - done by lock owners, contenders only signal an existing one
+			 */
+			WaiterSignal(const std::filesystem::path& file_path, bool create) noexcept {
+				auto signalPath = file_path;
+				signalPath += ".waiters";
+#if defined(_WIN32) || defined(_WIN64)
+				m_fileHandle = CreateFileW(signalPath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+				m_fileDescriptor = open(signalPath.c_str(), create ? (O_RDWR | O_CREAT) : O_RDWR, 0600);
+#else
+				(void)create;
+#endif
+			}
+
+			/**
+			 * @brief Withdraws a raised signal
+			 */
+			~WaiterSignal() noexcept {
+				CleanupResources();
+			}
+
+			/**
+			 * @brief Announces that this process waits for the lock until the signal is destroyed
+			 * @note Does nothing if the sidecar does not exist - then nobody keeps the lock on purpose
+			 */
+			void Raise() noexcept {
+				if (m_isRaised) {
+					return;
+				}
+#if defined(_WIN32) || defined(_WIN64)
+				if (m_fileHandle != INVALID_HANDLE_VALUE) {
+					// Blocking shared lock - HasWaiters() of the owner holds the exclusive one only for an instant
+					OVERLAPPED overlapped{};
+					m_isRaised = LockFileEx(m_fileHandle, 0, 0, 1, 0, &overlapped) != FALSE;
+				}
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+				if (m_fileDescriptor != -1) {
+					struct flock lockInfo = {
+						.l_type = F_RDLCK,      // Shared - any number of waiters at once
+						.l_whence = SEEK_SET,
+						.l_start = 0,
+						.l_len = 1
+					};
+					m_isRaised = fcntl(m_fileDescriptor, F_SETLK, &lockInfo) == 0;
+				}
+#endif
+			}
+
+			/**
+			 * @brief Returns whether another process currently waits for the lock
+			 * @return true if a waiter exists or the sidecar cannot be inspected - a lock is then never kept on purpose
+			 */
+			[[nodiscard]] bool HasWaiters() noexcept {
+#if defined(_WIN32) || defined(_WIN64)
+				if (m_fileHandle == INVALID_HANDLE_VALUE) {
+					return true;
+				}
+
+				// A waiter's shared lock makes the exclusive probe fail; without waiters it is dropped at once
+				OVERLAPPED overlapped{};
+				if (!LockFileEx(m_fileHandle, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &overlapped)) {
+					return true;
+				}
+				UnlockFileEx(m_fileHandle, 0, 1, 0, &overlapped);
+				return false;
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+				if (m_fileDescriptor == -1) {
+					return true;
+				}
+
+				// F_GETLK only reports locks of other processes and does not take one itself
+				struct flock lockInfo = {
+					.l_type = F_WRLCK,
+					.l_whence = SEEK_SET,
+					.l_start = 0,
+					.l_len = 1
+				};
+				if (fcntl(m_fileDescriptor, F_GETLK, &lockInfo) == -1) {
+					return true;
+				}
+				return lockInfo.l_type != F_UNLCK;
+#else
+				return true;
+#endif
+			}
+
+			// Disable copy and move operations
+			WaiterSignal(const WaiterSignal&) = delete;
+			WaiterSignal& operator=(const WaiterSignal&) = delete;
+			WaiterSignal(WaiterSignal&&) = delete;
+			WaiterSignal& operator=(WaiterSignal&&) = delete;
+
+		private:
+			/**
+			* @brief Internal cleanup method - not virtual / CppCheck warning PVS-Studio/PC-Lint
+			*/
+			void CleanupResources() noexcept {
+#if defined(_WIN32) || defined(_WIN64)
+				if (m_fileHandle != INVALID_HANDLE_VALUE) {
+					if (m_isRaised) {
+						OVERLAPPED overlapped{};
+						UnlockFileEx(m_fileHandle, 0, 1, 0, &overlapped);
+					}
+					CloseHandle(m_fileHandle);
+					m_fileHandle = INVALID_HANDLE_VALUE;
+				}
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+				if (m_fileDescriptor != -1) {
+					close(m_fileDescriptor); // Also drops the shared lock of a raised signal
+					m_fileDescriptor = -1;
+				}
+#endif
+				m_isRaised = false;
+			}
+
+#if defined(_WIN32) || defined(_WIN64)
+			HANDLE m_fileHandle{ INVALID_HANDLE_VALUE };
+#elif defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+			int m_fileDescriptor{ -1 };
+#endif
+			bool m_isRaised{ false };
+		};
+	} // namespace detail
+} // namespace file_lock
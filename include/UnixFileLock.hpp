@@ -19,6 +19,8 @@
 #include <functional>
 #include <chrono>
 #include <mutex>
+#include <optional>
+#include <stop_token>
 #include <unordered_set>
 #include <utility>
 #include <thread>
@@ -28,6 +30,7 @@
 #include <unistd.h>
 
 #include "FileLockStrategy.hpp"
+#include "FileLockWaiters.hpp"
 
 namespace file_lock {
 	namespace detail {
@@ -85,8 +88,17 @@ namespace file_lock {
 					.l_len = 0              // Lock entire file (0 = until EOF)
 				};
 
-				// Lock entire file (blocking - waits until lock is available)
-				if (fcntl(m_fileDescriptor, F_SETLKW, &lockInfo) == 0) {
+				// Try first - only an actual wait signals a process that keeps the lock biased (see FileLockWaiters.hpp)
+				int result = fcntl(m_fileDescriptor, F_SETLK, &lockInfo);
+				if (result == -1 && IsLockConflict()) {
+					WaiterSignal waiters(m_filePath, false);
+					waiters.Raise();
+
+					// Lock entire file (blocking - waits until lock is available)
+					result = fcntl(m_fileDescriptor, F_SETLKW, &lockInfo);
+				}
+
+				if (result == 0) {
 					m_isLocked = true;
 					return true;
 				}
@@ -126,18 +138,46 @@ namespace file_lock {
 			}
 
 			[[nodiscard]] bool try_lock_for(std::chrono::milliseconds timeout) noexcept override {
+				return PollLock(DeadlineAfter(timeout), std::stop_token{}) == LockStatus::Acquired;
+			}
+
+			[[nodiscard]] LockStatus lock(std::stop_token stopToken) noexcept override {
+				// Nobody can cancel - keep the kernel-side wait of F_SETLKW
+				if (!stopToken.stop_possible()) {
+					return lock() ? LockStatus::Acquired : LockStatus::Failed;
+				}
+				return PollLock(std::nullopt, stopToken);
+			}
+
+			[[nodiscard]] LockStatus try_lock_for(std::chrono::milliseconds timeout, std::stop_token stopToken) noexcept override {
+				return PollLock(DeadlineAfter(timeout), stopToken);
+			}
+
+			void unlock() noexcept override {
+				CleanupResources();
+			}
+
+		private:
+			/**
+			* @brief Polling loop shared by the timed and cancellable acquisitions
+			* F_SETLKW cannot be interrupted without signals, so F_SETLK is retried between interruptible sleeps.
+			* Any error other than a lock conflict fails. The waiter signal is raised from the first conflict on.
+			* @param deadline Absolute timeout, std::nullopt to wait until acquired or cancelled
+			* @param stopToken Token that cancels the wait, checked between attempts and during every sleep
+			*/
+			[[nodiscard]] LockStatus PollLock(std::optional<std::chrono::steady_clock::time_point> deadline, const std::stop_token& stopToken) noexcept {
 				if (m_isLocked) {
-					return true;
+					return LockStatus::Acquired;
+				}
+				if (stopToken.stop_requested()) {
+					return LockStatus::Cancelled;
 				}
 
 				m_fileDescriptor = open(m_filePath.c_str(), O_RDWR | O_CREAT, 0600);
 				if (m_fileDescriptor == -1) {
-					return false;
+					return LockStatus::Failed;
 				}
 
-				auto start = std::chrono::steady_clock::now();
-				auto deadline = start + timeout;
-
 				struct flock lockInfo = {
 					.l_type = F_WRLCK,      // Exclusive write lock
 					.l_whence = SEEK_SET,   // From beginning of file
@@ -145,38 +185,53 @@ namespace file_lock {
 					.l_len = 0              // Lock entire file (0 = until EOF)
 				};
 
-				// Try acquire lock with polling
-				while (std::chrono::steady_clock::now() < deadline) {
+				LockStatus status = LockStatus::TimedOut;
+				std::optional<WaiterSignal> waiters;
+				while (true) {
 					if (fcntl(m_fileDescriptor, F_SETLK, &lockInfo) == 0) {
 						m_isLocked = true;
-						return true;
+						return LockStatus::Acquired;
+					}
+
+					// If error is not a lock conflict, fail immediately
+					if (!IsLockConflict()) {
+						status = LockStatus::Failed;
+						break;
 					}
 
-					// If error is not EAGAIN/EWOULDBLOCK, fail immediately
-					if (errno != EAGAIN && errno != EWOULDBLOCK) {
-						close(m_fileDescriptor);
-						m_fileDescriptor = -1;
-						return false;
+					if (!waiters) {
+						waiters.emplace(m_filePath, false);
+						waiters->Raise();
 					}
 
-					// Sleep for a short time before retry
-					auto remaining = deadline - std::chrono::steady_clock::now();
-					auto sleep_time = std::min<std::chrono::milliseconds>(std::chrono::duration_cast<std::chrono::milliseconds>(remaining), std::chrono::milliseconds(10));
-					if (sleep_time.count() > 0) {
-						std::this_thread::sleep_for(sleep_time);
+					auto sleep_time = LockPollInterval;
+					if (deadline) {
+						auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+						if (remaining.count() <= 0) {
+							break;
+						}
+						sleep_time = std::min(remaining, sleep_time);
+					}
+
+					if (!InterruptibleSleep(sleep_time, stopToken)) {
+						status = LockStatus::Cancelled;
+						break;
 					}
 				}
 
 				close(m_fileDescriptor);
 				m_fileDescriptor = -1;
-				return false;
+				return status;
 			}
 
-			void unlock() noexcept override {
-				CleanupResources();
+			/**
+			* @brief Returns whether errno of a failed F_SETLK means the lock is held elsewhere
+			* EAGAIN, EWOULDBLOCK and EACCES - POSIX allows either for a conflicting lock.
+			*/
+			[[nodiscard]] static bool IsLockConflict() noexcept {
+				return errno == EAGAIN || errno == EWOULDBLOCK || errno == EACCES;
 			}
 
-		private:
 			/**
 			* @brief Internal cleanup method - not virtual / CppCheck warning PVS-Studio/PC-Lint
 			*/
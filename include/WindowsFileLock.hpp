@@ -19,12 +19,15 @@
 #include <algorithm>
 #include <filesystem>
 #include <chrono>
+#include <optional>
+#include <stop_token>
 #include <utility>
 #include <thread>
 
 #include <windows.h>
 
 #include "FileLockStrategy.hpp"
+#include "FileLockWaiters.hpp"
 
 namespace file_lock {
 	namespace detail {
@@ -75,9 +78,19 @@ namespace file_lock {
 					return false;
 				}
 
-				// Lock entire file (blocking - waits until lock is available)
-				OVERLAPPED overlapped{}; // Note: NOT using LOCKFILE_FAIL_IMMEDIATELY flag for blocking behavior
-				if (LockFileEx(m_fileHandle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+				// Try first - only an actual wait signals a process that keeps the lock biased (see FileLockWaiters.hpp)
+				OVERLAPPED overlapped{};
+				BOOL result = LockFileEx(m_fileHandle, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, MAXDWORD, MAXDWORD, &overlapped);
+				if (!result && GetLastError() == ERROR_LOCK_VIOLATION) {
+					WaiterSignal waiters(m_filePath, false);
+					waiters.Raise();
+
+					// Lock entire file (blocking - waits until lock is available)
+					overlapped = {}; // Note: NOT using LOCKFILE_FAIL_IMMEDIATELY flag for blocking behavior
+					result = LockFileEx(m_fileHandle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped);
+				}
+
+				if (result) {
 					m_isLocked = true;
 					return true;
 				}
@@ -111,50 +124,85 @@ namespace file_lock {
 
 
 			[[nodiscard]] bool try_lock_for(std::chrono::milliseconds timeout) noexcept override {
+				return PollLock(DeadlineAfter(timeout), std::stop_token{}) == LockStatus::Acquired;
+			}
+
+			[[nodiscard]] LockStatus lock(std::stop_token stopToken) noexcept override {
+				// Nobody can cancel - keep the kernel-side wait of the blocking LockFileEx
+				if (!stopToken.stop_possible()) {
+					return lock() ? LockStatus::Acquired : LockStatus::Failed;
+				}
+				return PollLock(std::nullopt, stopToken);
+			}
+
+			[[nodiscard]] LockStatus try_lock_for(std::chrono::milliseconds timeout, std::stop_token stopToken) noexcept override {
+				return PollLock(DeadlineAfter(timeout), stopToken);
+			}
+
+			void unlock() noexcept override {
+				CleanupResources();
+			}
+		private:
+			/**
+			* @brief Polling loop shared by the timed and cancellable acquisitions
+			* Retries LockFileEx with LOCKFILE_FAIL_IMMEDIATELY between interruptible sleeps; any error other than
+			* ERROR_LOCK_VIOLATION fails. The waiter signal is raised from the first conflict on.
+			* @param deadline Absolute timeout, std::nullopt to wait until acquired or cancelled
+			* @param stopToken Token that cancels the wait, checked between attempts and during every sleep
+			*/
+			[[nodiscard]] LockStatus PollLock(std::optional<std::chrono::steady_clock::time_point> deadline, const std::stop_token& stopToken) noexcept {
 				if (m_isLocked) {
-					return true;
+					return LockStatus::Acquired;
+				}
+				if (stopToken.stop_requested()) {
+					return LockStatus::Cancelled;
 				}
 
 				m_fileHandle = CreateFileW(m_filePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
 				if (m_fileHandle == INVALID_HANDLE_VALUE) {
-					return false;
+					return LockStatus::Failed;
 				}
 
-				auto start = std::chrono::steady_clock::now();
-				auto deadline = start + timeout;
-
-				// Try acquire lock with polling
-				while (std::chrono::steady_clock::now() < deadline) {
+				LockStatus status = LockStatus::TimedOut;
+				std::optional<WaiterSignal> waiters;
+				while (true) {
 					OVERLAPPED overlapped{};
-					if (LockFileEx(m_fileHandle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+					if (LockFileEx(m_fileHandle, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, MAXDWORD, MAXDWORD, &overlapped)) {
 						m_isLocked = true;
-						return true;
+						return LockStatus::Acquired;
 					}
 
 					// If error is not ERROR_LOCK_VIOLATION, fail immediately
 					if (GetLastError() != ERROR_LOCK_VIOLATION) {
-						CloseHandle(m_fileHandle);
-						m_fileHandle = INVALID_HANDLE_VALUE;
-						return false;
+						status = LockStatus::Failed;
+						break;
+					}
+
+					if (!waiters) {
+						waiters.emplace(m_filePath, false);
+						waiters->Raise();
 					}
 
-					// Sleep for a short time before retry
-					auto remaining = deadline - std::chrono::steady_clock::now();
-					auto sleep_time = std::min<std::chrono::milliseconds>(std::chrono::duration_cast<std::chrono::milliseconds>(remaining), std::chrono::milliseconds(10));
-					if (sleep_time.count() > 0) {
-						std::this_thread::sleep_for(sleep_time);
+					auto sleep_time = LockPollInterval;
+					if (deadline) {
+						auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+						if (remaining.count() <= 0) {
+							break;
+						}
+						sleep_time = std::min(remaining, sleep_time);
+					}
+
+					if (!InterruptibleSleep(sleep_time, stopToken)) {
+						status = LockStatus::Cancelled;
+						break;
 					}
 				}
 
 				CloseHandle(m_fileHandle);
 				m_fileHandle = INVALID_HANDLE_VALUE;
-				return false;
+				return status;
 			}
 
-			void unlock() noexcept override {
-				CleanupResources();
-			}
-		private:
 			/**
 			* @brief Internal cleanup method - not virtual / CppCheck warning PVS-Studio/PC-Lint
 			*/
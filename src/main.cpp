@@ -10,10 +10,19 @@
 * @warning .txt files is not automatically deleted. However, such lock files are usually located in /tmp etc.
 */
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <thread>
 
+#if defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "../include/FileLockCondition.hpp"
+#include "../include/FileLockElection.hpp"
 #include "../include/FileLockFactory.hpp"
 
 void TestBlockingLock() {
@@ -68,6 +77,187 @@ void TestTimedLock() {
 	std::cout << "Test - Timed Lock End\n";
 }
 
+void TestCancellableLock() {
+	std::cout << "\nTest - Cancellable Lock Start\n";
+
+	// First terminal holds the lock, second terminal waits and gets cancelled
+	auto holder = file_lock::FileLockFactory::CreateTryLockContext("TestCancellableLock.txt");
+	if (holder != nullptr) {
+		std::cout << "Cancellable lock is acquire, sleep 10 seconds (run the test again in another terminal)\n";
+		std::this_thread::sleep_for(std::chrono::seconds(10));
+		std::cout << "Test - Cancellable Lock End\n";
+		return;
+	}
+
+	std::atomic<std::chrono::steady_clock::rep> returnedAt{ 0 };
+	file_lock::LockStatus status = file_lock::LockStatus::Failed;
+	std::jthread worker([&](std::stop_token stopToken) {
+		auto result = file_lock::FileLockFactory::CreateLockContext("TestCancellableLock.txt", stopToken);
+		returnedAt = std::chrono::steady_clock::now().time_since_epoch().count();
+		status = result.status;
+	});
+
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+	const auto stoppedAt = std::chrono::steady_clock::now();
+	worker.request_stop();
+	worker.join();
+
+	const auto latency = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(returnedAt.load())) - stoppedAt;
+	std::cout << "Wait " << (status == file_lock::LockStatus::Cancelled ? "cancelled" : "not cancelled") << " "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(latency).count() << " us after the stop request\n";
+	std::cout << "Test - Cancellable Lock End\n";
+}
+
+void TestBiasedLock() {
+	std::cout << "\nTest - Biased Lock Start\n";
+
+	constexpr int iterations = 10000;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		auto lock = file_lock::FileLockFactory::CreateLockContext("TestBiasedLock.txt");
+	}
+	auto plain = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		auto lock = file_lock::FileLockFactory::CreateBiasedLockContext("TestBiasedLock.txt");
+	}
+	auto biased = std::chrono::steady_clock::now() - start;
+
+	std::cout << "Plain acquisition: " << std::chrono::duration_cast<std::chrono::nanoseconds>(plain).count() / iterations << " ns\n";
+	std::cout << "Biased acquisition: " << std::chrono::duration_cast<std::chrono::nanoseconds>(biased).count() / iterations << " ns\n";
+
+	// The kernel lock is still held although no context exists - a second terminal revokes it within milliseconds
+	std::cout << "Biased lock is idle but kept, sleep 10 seconds\n";
+	std::this_thread::sleep_for(std::chrono::seconds(10));
+
+	start = std::chrono::steady_clock::now();
+	auto lock = file_lock::FileLockFactory::CreateBiasedLockContext("TestBiasedLock.txt");
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Biased lock reacquired after " << ms << " ms\n";
+	std::cout << "Test - Biased Lock End\n";
+}
+
+void TestConditionWait() {
+	std::cout << "\nTest - Condition Wait Start\n";
+
+	file_lock::FileLockCondition condition("TestCondition.txt");
+	auto lock = file_lock::FileLockFactory::CreateLockContext("TestCondition.txt");
+	if (lock == nullptr) {
+		std::cerr << "[FAIL] - Condition lock is not acquire!\n";
+		return;
+	}
+
+	std::cout << "Condition lock is acquire, waiting up to 30 seconds for a change (run TestConditionNotify in another terminal)\n";
+	auto start = std::chrono::steady_clock::now();
+	bool changed = condition.wait_for(*lock, std::chrono::seconds(30));
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << (changed ? "Change observed" : "Timed out") << " after " << ms << " ms, lock reacquired: " << lock->IsLockAcquired() << "\n";
+	std::cout << "Test - Condition Wait End\n";
+}
+
+void TestConditionNotify() {
+	std::cout << "\nTest - Condition Notify Start\n";
+
+	file_lock::FileLockCondition condition("TestCondition.txt");
+	auto lock = file_lock::FileLockFactory::CreateLockContext("TestCondition.txt");
+	if (lock == nullptr) {
+		std::cerr << "[FAIL] - Condition lock is not acquire!\n";
+		return;
+	}
+
+	std::cout << "Notify result: " << condition.notify_all() << "\n";
+	std::cout << "Test - Condition Notify End\n";
+}
+
+void TestLeaderElection() {
+	std::cout << "\nTest - Leader Election Start\n";
+
+	file_lock::LeaderElection election("TestLeaderElection.txt", {
+		.onElected = [] { std::cout << "Elected as leader\n"; },
+		.onLostLeadership = [] { std::cout << "Leadership lost\n"; }
+	});
+
+	if (auto leader = election.GetLeader()) {
+		std::cout << "Current leader record: PID " << leader->pid << "\n";
+	}
+
+	std::cout << "Campaigning (blocking), close or kill the leader terminal to take over\n";
+	if (election.Campaign()) {
+		std::cout << "Leader for 10 seconds\n";
+		std::this_thread::sleep_for(std::chrono::seconds(10));
+		election.Resign();
+	}
+	else {
+		std::cerr << "[FAIL] - Campaign failed!\n";
+	}
+
+	std::cout << "Test - Leader Election End\n";
+}
+
+#if defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+void TestLeaderFailover() {
+	std::cout << "\nTest - Leader Failover Start\n";
+
+	// Leader is a forked child, so the standby below is a genuinely different process
+	const pid_t leaderPid = fork();
+	if (leaderPid == 0) {
+		file_lock::LeaderElection leader("TestLeaderFailover.txt");
+		if (leader.Campaign()) {
+			pause();
+		}
+		_exit(1);
+	}
+
+	int childStatus = 0;
+	const auto electionDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	auto leader = file_lock::LeaderElection::ReadLeaderRecord("TestLeaderFailover.txt");
+	while (!leader || leader->pid != leaderPid) {
+		if (waitpid(leaderPid, &childStatus, WNOHANG) == leaderPid) {
+			std::cerr << "[FAIL] - Forked leader exited before being elected, status " << childStatus << "!\n";
+			return;
+		}
+		if (std::chrono::steady_clock::now() >= electionDeadline) {
+			std::cerr << "[FAIL] - Forked leader was not elected within 5 seconds!\n";
+			kill(leaderPid, SIGKILL);
+			waitpid(leaderPid, nullptr, 0);
+			return;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		leader = file_lock::LeaderElection::ReadLeaderRecord("TestLeaderFailover.txt");
+	}
+
+	std::atomic<std::chrono::steady_clock::rep> electedAt{ 0 };
+	file_lock::LeaderElection standby("TestLeaderFailover.txt", {
+		.onElected = [&electedAt] { electedAt = std::chrono::steady_clock::now().time_since_epoch().count(); },
+		.onLostLeadership = {}
+	});
+	standby.CampaignAsync();
+	std::this_thread::sleep_for(std::chrono::milliseconds(200)); // Let the standby settle into waiting
+
+	const auto killedAt = std::chrono::steady_clock::now();
+	kill(leaderPid, SIGKILL);
+	if (waitpid(leaderPid, &childStatus, 0) != leaderPid || !WIFSIGNALED(childStatus) || WTERMSIG(childStatus) != SIGKILL) {
+		std::cerr << "[FAIL] - Forked leader did not die from SIGKILL, status " << childStatus << "!\n";
+		return;
+	}
+
+	const auto failoverDeadline = killedAt + std::chrono::seconds(5);
+	while (electedAt == 0) {
+		if (std::chrono::steady_clock::now() >= failoverDeadline) {
+			std::cerr << "[FAIL] - Standby was not elected within 5 seconds after the leader was killed!\n";
+			return;
+		}
+		std::this_thread::yield();
+	}
+
+	const auto failover = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(electedAt.load())) - killedAt;
+	std::cout << "Standby took over " << std::chrono::duration_cast<std::chrono::microseconds>(failover).count() << " us after the leader was killed\n";
+	std::cout << "Test - Leader Failover End\n";
+}
+#endif
+
 int main() {
 	std::cout << "===============================================================================================\n";
 	std::cout << "======================= Cross-Platform File Lock Library - Simple Tests =======================\n";
@@ -79,6 +269,14 @@ int main() {
 	//TestBlockingLock();
 	//TestNonBlockingLock();
 	//TestTimedLock();
+	//TestCancellableLock();
+	//TestBiasedLock();
+	//TestConditionWait();
+	//TestConditionNotify();
+	//TestLeaderElection();
+#if defined(__linux) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+	//TestLeaderFailover();
+#endif
 
 	std::cout << std::endl;
 }